@@ -0,0 +1,79 @@
+#!/usr/bin/env python
+# Check that heft_prepare_traindata_gauss (C++) with --smear 0 --replicas 1
+# produces the same rows, up to shuffling, as the expansion done in
+# heft_prepare_traindata_gauss.py, and that its .bin file matches its csv.
+#
+# usage: python check_heft_traindata_gauss.py <path to heft_prepare_traindata_gauss>
+#                                             [powheg_total_param_gauss_oldStyle.csv]
+import os, sys, csv, math, struct, subprocess, tempfile
+
+def read_csv(filename):
+    with open(filename) as f:
+        rows = list(csv.reader(f))
+    return rows[0], rows[1:]
+
+def expected_rows(datafile, first='17', last='96'):
+    # same steps as heft_prepare_traindata_gauss.py, without shuffling
+    columns, rows = read_csv(datafile)
+    firstbin = columns.index(first)
+    lastbin  = columns.index(last)
+
+    xbins = lastbin - firstbin + 1
+    xmax  = xbins/100.
+    step  = xmax / xbins
+    x = [i*step for i in range(xbins)] + [xmax]   # numpy.linspace
+    x = [(x[i+1]+x[i])/2 for i in range(xbins)]
+
+    data = []
+    for row in rows:
+        p = [float(v) for v in row[0:5]]
+        spectrum = [max(0.0, float(v)) for v in row[firstbin:lastbin+1]]
+        for mhh, sigma in zip(x, spectrum):
+            data.append(p + [mhh, sigma])
+    return data
+
+def read_bin(filename):
+    with open(filename, 'rb') as f:
+        assert f.read(8) == b'HEFTCOL1'
+        ncols, nrows = struct.unpack('<QQ', f.read(16))
+        names = []
+        for _ in range(ncols):
+            size, = struct.unpack('<Q', f.read(8))
+            names.append(f.read(size).decode())
+        cols = [struct.unpack('<%dd' % nrows, f.read(8*nrows))
+                for _ in range(ncols)]
+    return names, [list(r) for r in zip(*cols)]
+
+def same(a, b):
+    return all(math.isclose(u, v, rel_tol=1e-12, abs_tol=1e-15)
+               for u, v in zip(a, b))
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit('usage: check_heft_traindata_gauss.py <program> [datafile]')
+    program  = sys.argv[1]
+    datafile = sys.argv[2] if len(sys.argv) > 2 else \
+        'powheg_total_param_gauss_oldStyle.csv'
+
+    with tempfile.TemporaryDirectory() as tmp:
+        output = os.path.join(tmp, 'traindata.csv')
+        subprocess.run([program, '--input', datafile, '--output', output,
+                        '--smear', '0', '--replicas', '1',
+                        '--skip', '0', '--multiple', '1'], check=True)
+        names, rows = read_csv(output)
+        rows = [[float(v) for v in row] for row in rows]
+        bnames, brows = read_bin(os.path.join(tmp, 'traindata.bin'))
+
+    assert names == ['klambda', 'CT', 'CTT', 'CGGH', 'CGGHH', 'mhh', 'sigma']
+    assert bnames == names, 'bin and csv column names differ'
+    assert brows == rows, 'bin and csv values differ'
+
+    expected = sorted(expected_rows(datafile))
+    rows     = sorted(rows)
+    assert len(rows) == len(expected), \
+        'expected %d rows, found %d' % (len(expected), len(rows))
+    for a, b in zip(rows, expected):
+        assert same(a, b), 'row %s differs from %s' % (a, b)
+    print('OK: %d rows agree with heft_prepare_traindata_gauss.py' % len(rows))
+
+main()
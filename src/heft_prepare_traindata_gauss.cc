@@ -0,0 +1,445 @@
+// ---------------------------------------------------------------------------
+// File: heft_prepare_traindata_gauss.cc
+// Description: Multithreaded version of heft_prepare_traindata_gauss.py.
+//   read spectra csv -> clip negative cross sections -> Gaussian smear
+//   -> expand to long (params, mhh, sigma) format -> shuffle -> write.
+//
+// The first five columns of the input are written under the canonical
+// names klambda, CT, CTT, CGGH, CGGHH used by the training notebooks,
+// whatever they are called in the input (the gauss input files call the
+// fourth one CGHH).
+//
+// The output is written both as a csv file and as a columnar binary file
+// with the same stem and extension .bin. All integers and floats are
+// little-endian, whatever the byte order of the host:
+//
+//   char[8]   magic "HEFTCOL1"
+//   uint64    number of columns
+//   uint64    number of rows
+//   for each column: uint64 name length, name characters
+//   for each column: number-of-rows float64 values
+//
+// Only the spectra and the row permutation are held in memory. Rows are
+// computed, formatted and written in batches, in parallel, and the
+// batches are appended to both files as soon as they are ready. The
+// shuffles are Fisher-Yates shuffles and the smearing of each row uses
+// Gaussian variates, both driven by a counter-based random number
+// generator keyed on the seed, so the output depends only on the seed,
+// not on the batch size, the number of threads or the standard library's
+// random number engines. (Smeared values use log and cos, so they can
+// differ in the last bit between math libraries.)
+//
+// Build:
+//   g++ -O2 -std=c++17 -pthread -o heft_prepare_traindata_gauss
+//       heft_prepare_traindata_gauss.cc
+//
+// Usage:
+//   heft_prepare_traindata_gauss [--input powheg_total_param_gauss_oldStyle.csv]
+//        [--output heft_gauss_traindata.csv] [--first 17] [--last 96]
+//        [--skip 40] [--replicas 1] [--smear 0] [--seed 42]
+//        [--threads 0] [--batch 10000] [--multiple 1000]
+//
+//   --skip      number of (shuffled) spectra kept back for testing
+//   --replicas  number of smeared copies of each spectrum
+//   --smear     relative width of the Gaussian smearing of each bin
+//   --batch     number of rows per batch
+//   --multiple  truncate the number of rows to a multiple of this value
+//
+// check_heft_traindata_gauss.py checks the output against the expansion
+// done by heft_prepare_traindata_gauss.py.
+// ---------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+// ---------------------------------------------------------------------------
+using namespace std;
+
+namespace {
+  const size_t NPARAMS = 5;  // number of Wilson coefficients
+  const char*  PARAMS[NPARAMS] = {"klambda", "CT", "CTT", "CGGH", "CGGHH"};
+
+  struct Options
+  {
+    string   input    = "powheg_total_param_gauss_oldStyle.csv";
+    string   output   = "heft_gauss_traindata.csv";
+    string   first    = "17";
+    string   last     = "96";
+    size_t   skip     = 40;
+    size_t   replicas = 1;
+    double   smear    = 0;
+    uint64_t seed     = 42;
+    size_t   threads  = 0;
+    size_t   batch    = 10000;
+    size_t   multiple = 1000;
+  };
+
+  // Spectra in row-major order: nrows x (NPARAMS + nbins)
+  struct Spectra
+  {
+    size_t         nbins;
+    size_t         nrows;
+    vector<double> data;
+  };
+
+  uint64_t mix64(uint64_t z)
+  {
+    // splitmix64 finalizer
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  // Fisher-Yates shuffle of v driven by mix64, so the permutation
+  // depends only on (seed, stream)
+  template <class T>
+  void shuffle(vector<T>& v, uint64_t seed, uint64_t stream)
+  {
+    uint64_t key = mix64(seed ^ mix64(stream));
+    for (size_t i=v.size(); i > 1; i--)
+      {
+	size_t j = mix64(key + 0x9e3779b97f4a7c15ULL * i) % i;
+	swap(v[i-1], v[j]);
+      }
+  }
+
+  // write count 8-byte values (uint64 or float64) in little-endian order
+  void writeLittleEndian(ostream& out, const void* data, size_t count)
+  {
+    const uint16_t one = 1;
+    if ( *(const unsigned char*)&one == 1 )
+      {
+	out.write((const char*)data, count * 8);
+	return;
+      }
+    vector<uint64_t> buffer(count);
+    memcpy(buffer.data(), data, count * 8);
+    for (size_t i=0; i < count; i++)
+      {
+	uint64_t x = buffer[i], y = 0;
+	for (int b=0; b < 8; b++, x >>= 8) y = (y << 8) | (x & 0xff);
+	buffer[i] = y;
+      }
+    out.write((const char*)buffer.data(), count * 8);
+  }
+
+  // standard normal variate determined by (seed, counter) (Box-Muller)
+  double gauss(uint64_t seed, uint64_t counter)
+  {
+    uint64_t u  = mix64(seed ^ mix64(counter + 1));
+    double   u1 = ((u >> 32) + 0.5) / 4294967296.0;
+    double   u2 = ((u & 0xffffffffULL) + 0.5) / 4294967296.0;
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+  }
+
+  // Call fn(batch, begin, end) for each batch of [0, n), distributing the
+  // batches dynamically over nthreads threads.
+  void forEachBatch(size_t n, size_t batchsize, size_t nthreads,
+		    function<void(size_t, size_t, size_t)> fn)
+  {
+    size_t nbatches = (n + batchsize - 1) / batchsize;
+    atomic<size_t> next(0);
+    auto worker = [&]()
+      {
+	for (size_t b = next++; b < nbatches; b = next++)
+	  fn(b, b*batchsize, min(n, (b+1)*batchsize));
+      };
+    nthreads = max((size_t)1, min(nthreads, nbatches));
+    vector<thread> pool;
+    for (size_t i=1; i < nthreads; i++) pool.push_back(thread(worker));
+    worker();
+    for (size_t i=0; i < pool.size(); i++) pool[i].join();
+  }
+
+  vector<string> split(const string& line)
+  {
+    vector<string> fields;
+    stringstream in(line);
+    string field;
+    while ( getline(in, field, ',') ) fields.push_back(field);
+    return fields;
+  }
+
+  // convert field to a double, returning false unless the whole field
+  // (apart from surrounding white space) is a number
+  bool parse(const string& field, double& value)
+  {
+    const char* begin = field.c_str();
+    char* end = 0;
+    value = strtod(begin, &end);
+    if ( end == begin ) return false;
+    while ( *end != 0 && isspace((unsigned char)*end) ) end++;
+    return *end == 0;
+  }
+
+  Spectra readSpectra(const Options& opt)
+  {
+    cout << "reading " << opt.input << endl;
+    ifstream in(opt.input);
+    if ( !in )
+      throw runtime_error("unable to open " + opt.input);
+
+    string line;
+    getline(in, line);
+    vector<string> columns = split(line);
+    size_t firstbin = find(columns.begin(), columns.end(), opt.first)
+      - columns.begin();
+    size_t lastbin  = find(columns.begin(), columns.end(), opt.last)
+      - columns.begin();
+    if ( columns.size() < NPARAMS ||
+	 lastbin >= columns.size() || firstbin > lastbin )
+      throw runtime_error("bin columns " + opt.first + ".." + opt.last +
+			  " not found in " + opt.input);
+
+    Spectra s;
+    s.nbins = lastbin - firstbin + 1;
+
+    vector<string> lines;
+    while ( getline(in, line) )
+      if ( line.size() > 0 ) lines.push_back(line);
+    s.nrows = lines.size();
+
+    // parse and clip negative cross sections
+    size_t width = NPARAMS + s.nbins;
+    s.data = vector<double>(s.nrows * width);
+    atomic<bool> shortrow(false);
+    atomic<bool> badfield(false);
+    forEachBatch(s.nrows, 1000, opt.threads,
+		 [&](size_t, size_t begin, size_t end)
+		 {
+		   for (size_t row=begin; row < end; row++)
+		     {
+		       vector<string> f = split(lines[row]);
+		       if ( f.size() <= lastbin )
+			 {
+			   shortrow = true;
+			   continue;
+			 }
+		       double* out = &s.data[row * width];
+		       for (size_t j=0; j < NPARAMS; j++)
+			 if ( !parse(f[j], out[j]) ) badfield = true;
+		       for (size_t j=0; j < s.nbins; j++)
+			 {
+			   double& x = out[NPARAMS+j];
+			   if ( !parse(f[firstbin+j], x) ) badfield = true;
+			   x = max(0.0, x);
+			 }
+		     }
+		 });
+    if ( shortrow )
+      throw runtime_error("short row in " + opt.input);
+    if ( badfield )
+      throw runtime_error("malformed field in " + opt.input);
+    cout << "number of rows read: " << s.nrows << endl;
+    return s;
+  }
+
+  // Long-format rows. Row g = i * nbins + j is bin j of replica
+  // i % replicas of spectrum order[i / replicas].
+  struct Expansion
+  {
+    Expansion(const Spectra& s_, const Options& opt_)
+      : s(s_), opt(opt_), mhh(s_.nbins)
+    {
+      // shuffle spectra and keep back the first opt.skip for testing
+      for (size_t i=0; i < s.nrows; i++) order.push_back(i);
+      shuffle(order, opt.seed, 1);
+      order.erase(order.begin(),
+		  order.begin() + min(opt.skip, order.size()));
+
+      // mid-points of the di-Higgs mass bins, with the mass range mapped
+      // to [0, nbins/100] (bin width 0.01), computed as numpy.linspace
+      // does in heft_prepare_traindata_gauss.py
+      double xmax = s.nbins / 100.;
+      double step = xmax / s.nbins;
+      for (size_t j=0; j < s.nbins; j++)
+	{
+	  double lo = j * step;
+	  double hi = j+1 < s.nbins ? (j+1) * step : xmax;
+	  mhh[j] = (lo + hi) / 2;
+	}
+
+      // shuffle rows and truncate to a multiple of opt.multiple
+      size_t nrows = order.size() * opt.replicas * s.nbins;
+      perm.resize(nrows);
+      for (size_t g=0; g < nrows; g++) perm[g] = g;
+      shuffle(perm, opt.seed, 2);
+      if ( opt.multiple > 0 )
+	perm.resize(nrows / opt.multiple * opt.multiple);
+    }
+
+    size_t ncolumns() const { return NPARAMS + 2; }
+    size_t nrows() const { return perm.size(); }
+
+    // values of output row
+    void row(size_t r, double* out) const
+    {
+      size_t g = perm[r];
+      size_t i = g / s.nbins;
+      size_t j = g % s.nbins;
+      const double* in = &s.data[order[i / opt.replicas]
+				 * (NPARAMS + s.nbins)];
+      for (size_t k=0; k < NPARAMS; k++) out[k] = in[k];
+      double sigma = in[NPARAMS+j];
+      if ( opt.smear > 0 )
+	sigma = max(0.0, sigma * (1 + opt.smear * gauss(opt.seed, g)));
+      out[NPARAMS]   = mhh[j];
+      out[NPARAMS+1] = sigma;
+    }
+
+    const Spectra& s;
+    const Options& opt;
+    vector<double> mhh;
+    vector<size_t> order;
+    vector<size_t> perm;
+  };
+
+  string binaryName(const string& output)
+  {
+    string filename = output;
+    size_t dot = filename.rfind('.');
+    if ( dot != string::npos && filename.find('/', dot) == string::npos )
+      filename = filename.substr(0, dot);
+    return filename + ".bin";
+  }
+
+  void write(const Expansion& e, const Options& opt)
+  {
+    vector<string> names(PARAMS, PARAMS + NPARAMS);
+    names.push_back("mhh");
+    names.push_back("sigma");
+    size_t   ncols = e.ncolumns();
+    uint64_t nrows = e.nrows();
+
+    ofstream csv(opt.output);
+    if ( !csv )
+      throw runtime_error("unable to open " + opt.output);
+    for (size_t k=0; k < ncols; k++)
+      csv << (k ? "," : "") << names[k];
+    csv << '\n';
+
+    string binname = binaryName(opt.output);
+    ofstream bin(binname, ios::binary);
+    if ( !bin )
+      throw runtime_error("unable to open " + binname);
+    uint64_t n = ncols;
+    bin.write("HEFTCOL1", 8);
+    writeLittleEndian(bin, &n, 1);
+    writeLittleEndian(bin, &nrows, 1);
+    for (size_t k=0; k < ncols; k++)
+      {
+	uint64_t size = names[k].size();
+	writeLittleEndian(bin, &size, 1);
+	bin.write(names[k].data(), size);
+      }
+    streamoff start = bin.tellp();
+
+    // Each chunk holds one batch per thread. The batches of a chunk are
+    // computed and formatted in parallel, then appended in order to the
+    // csv file and written into place in each column of the binary file.
+    size_t chunksize = opt.batch * opt.threads;
+    vector<string> text(opt.threads);
+    vector<vector<double> > values(ncols, vector<double>(chunksize));
+    for (size_t first=0; first < nrows; first += chunksize)
+      {
+	size_t count = min((size_t)nrows - first, chunksize);
+	forEachBatch(count, opt.batch, opt.threads,
+		     [&](size_t b, size_t begin, size_t end)
+		     {
+		       char buffer[32];
+		       double out[NPARAMS + 2];
+		       string& s = text[b];
+		       s.clear();
+		       for (size_t r=begin; r < end; r++)
+			 {
+			   e.row(first + r, out);
+			   for (size_t k=0; k < ncols; k++)
+			     {
+			       values[k][r] = out[k];
+			       to_chars_result t = to_chars(buffer,
+							    buffer
+							    + sizeof(buffer),
+							    out[k]);
+			       s.append(buffer, t.ptr);
+			       s += (k+1 < ncols ? ',' : '\n');
+			     }
+			 }
+		     });
+	size_t nbatches = (count + opt.batch - 1) / opt.batch;
+	for (size_t b=0; b < nbatches; b++) csv << text[b];
+	for (size_t k=0; k < ncols; k++)
+	  {
+	    bin.seekp(start + (streamoff)((k * nrows + first)
+					  * sizeof(double)));
+	    writeLittleEndian(bin, values[k].data(), count);
+	  }
+      }
+    if ( !csv )
+      throw runtime_error("error writing " + opt.output);
+    if ( !bin )
+      throw runtime_error("error writing " + binname);
+    cout << "training data size: " << nrows << endl;
+    cout << "written " << opt.output << endl;
+    cout << "written " << binname << endl;
+  }
+
+  Options parseOptions(int argc, char** argv)
+  {
+    Options opt;
+    for (int i=1; i < argc; i++)
+      {
+	string key = argv[i];
+	if ( i+1 >= argc )
+	  throw runtime_error("missing value for " + key);
+	string value = argv[++i];
+	if      ( key == "--input" )    opt.input    = value;
+	else if ( key == "--output" )   opt.output   = value;
+	else if ( key == "--first" )    opt.first    = value;
+	else if ( key == "--last" )     opt.last     = value;
+	else if ( key == "--skip" )     opt.skip     = stoul(value);
+	else if ( key == "--replicas" ) opt.replicas = stoul(value);
+	else if ( key == "--smear" )    opt.smear    = stod(value);
+	else if ( key == "--seed" )     opt.seed     = stoull(value);
+	else if ( key == "--threads" )  opt.threads  = stoul(value);
+	else if ( key == "--batch" )    opt.batch    = stoul(value);
+	else if ( key == "--multiple" ) opt.multiple = stoul(value);
+	else
+	  throw runtime_error("unknown option " + key);
+      }
+    if ( opt.threads == 0 ) opt.threads = thread::hardware_concurrency();
+    if ( opt.threads == 0 ) opt.threads = 1;
+    if ( opt.batch == 0 )   opt.batch   = 10000;
+    if ( opt.replicas == 0 )
+      throw runtime_error("--replicas must be at least 1");
+    return opt;
+  }
+};
+
+int main(int argc, char** argv)
+{
+  try
+    {
+      Options   opt = parseOptions(argc, argv);
+      Spectra   s   = readSpectra(opt);
+      Expansion e(s, opt);
+      write(e, opt);
+    }
+  catch (exception& e)
+    {
+      cerr << "heft_prepare_traindata_gauss: " << e.what() << endl;
+      return 1;
+    }
+  return 0;
+}
@@ -4,12 +4,50 @@
 // Created May 11, 2011 by Harrison Prosper and Sezen Sekmen
 // Updated May 21, 2015 HBP - Implement Fill
 //         May 18, 2019 HBP - add FindBin method
+//         Oct 19, 2026     - add Poisson bootstrap replicas (fillBootstrap)
+//         Oct 19, 2026     - add metrics and optional progress reporting
 // ---------------------------------------------------------------------------
 #include <vector>
 #include <string>
 #include <map>
+#include <functional>
 #include "TKDTreeBinning.h"
 // ---------------------------------------------------------------------------
+/// Timers (seconds), counters and occupancy statistics gathered by Turtle.
+struct TurtleMetrics
+{
+  TurtleMetrics()
+    : readTime(0), partitionTime(0), indexTime(0), fillTime(0),
+      eventsRead(0), eventsFilled(0), lookups(0), lookupsMissed(0),
+      minOccupancy(0), maxOccupancy(0), imbalance(0),
+      minCount(0), maxCount(0), bytesAllocated(0) {}
+
+  double readTime;        /// reading ROOT files into memory
+  double partitionTime;   /// building the binary partition
+  double indexTime;       /// building the bin -> indices map
+  double fillTime;        /// last fill or fillBootstrap from files or array
+
+  size_t eventsRead;      /// events used to build the partition
+  size_t eventsFilled;    /// events histogrammed
+  size_t lookups;         /// bin lookups made while building the index
+                          /// map and filling
+  size_t lookupsMissed;   /// lookups that did not return a valid bin
+
+  size_t minOccupancy;    /// fewest points in a bin of the partition
+  size_t maxOccupancy;    /// most points in a bin of the partition
+  double imbalance;       /// maxOccupancy / mean occupancy
+  double minCount;        /// smallest bin count of the last fill
+  double maxCount;        /// largest bin count of the last fill
+
+  size_t bytesAllocated;  /// estimate of bytes currently held for data,
+                          /// partition, bins, indices and replicas
+                          /// (temporaries not included)
+};
+
+/// Progress callback: phase ("read", "index", "fill"), entry, total.
+typedef std::function<void(const std::string&, size_t, size_t)>
+TurtleCallback;
+
 ///
 class Turtle
 {
@@ -51,6 +89,14 @@ public:
 	     int numberofbins,
 	     int numberofpoints=-1);
 
+  /// Bin data from an array laid out as for the array constructor.
+  /// Use with the default constructor to enable progress reporting
+  /// (setProgress) before the partition and index map are built.
+  void build(double* data,
+	     int numberofbins,
+	     int numberofpoints,
+	     int numberofvariables);
+
   virtual ~Turtle();
   
   ///
@@ -136,6 +182,59 @@ public:
   /// Return bin variances for histogrammed data.
   std::vector<double> lowEdges() { return _variances; }
 
+  /// Histogram data from specified file and, in the same pass, fill
+  /// numberofreplicas bootstrap replicas in which each event enters
+  /// with a Poisson(1) multiplicity. The replicas are reproducible
+  /// for a given seed, independently of the number of threads used.
+  /// nthreads=0 uses one thread per core. A negative numberofreplicas
+  /// is reported on cerr and leaves the histogram unchanged.
+  void fillBootstrap(std::string rootfilename,
+		     int numberofreplicas,
+		     unsigned long seed=0,
+		     std::string weightname="",
+		     int nthreads=0);
+
+  /// Histogram data and bootstrap replicas from specified files.
+  void fillBootstrap(std::vector<std::string>& rootfilenames,
+		     int numberofreplicas,
+		     unsigned long seed=0,
+		     std::string weightname="",
+		     int nthreads=0);
+
+  /// Histogram data and bootstrap replicas from an array laid out as
+  /// for the array constructor (all values of variable 1, then of
+  /// variable 2, etc.). weights, if given, has numberofpoints entries.
+  void fillBootstrap(double* data,
+		     int numberofpoints,
+		     int numberofreplicas,
+		     unsigned long seed=0,
+		     double* weights=0,
+		     int nthreads=0);
+
+  /// Return number of bootstrap replicas.
+  size_t nReplicas() { return _numberofreplicas; }
+
+  /// Return bin counts for given bootstrap replica.
+  std::vector<double> replicaCounts(int replica);
+
+  /// Return bin variances computed from the spread of the replicas.
+  std::vector<double> bootstrapVariances();
+
+  /// Return timers, counters and occupancy statistics.
+  TurtleMetrics metrics();
+
+  /// Zero timers and counters.
+  void resetMetrics() { _metrics = TurtleMetrics(); }
+
+  /// Print metrics to cout.
+  void printMetrics();
+
+  /// Report progress at most once every interval seconds, to cout or,
+  /// if given, to callback. Reporting is off by default (interval <= 0).
+  /// To report on reading and index building, call before build.
+  void setProgress(double interval,
+		   TurtleCallback callback=TurtleCallback());
+
   
   ClassDef(Turtle,0)
   
@@ -146,6 +245,7 @@ public:
   std::string              _treename;
   std::vector<double>      _counts;
   std::vector<double>      _variances;
+  std::vector<double>      _replicas;  // [replica][bin]
   std::map<int, std::vector<int> > _indicesmap;
   
   size_t  _numberofbins;
@@ -154,6 +254,12 @@ public:
   double* _data;
   double* _point;
   size_t  _numberofvars;
+  size_t  _numberofreplicas;
+
+  TurtleMetrics  _metrics;
+  double         _interval;
+  double         _lastreport;
+  TurtleCallback _callback;
   
   double* _readTree(std::vector<std::string>& rootfilenames, 
                     std::vector<std::string>& variablenames, 
@@ -163,6 +269,23 @@ public:
 
   /// Build map from bin number to the indices of the points within the bin
   void _buildIndicesMap();
+
+  /// Report progress if enabled. The clock is checked only every 4096
+  /// entries, so this is a single branch when reporting is off.
+  void _progress(const char* phase, size_t entry, size_t total)
+  {
+    if ( _interval > 0 && (entry & 0xfff) == 0 )
+      _report(phase, entry, total);
+  }
+  void _report(const char* phase, size_t entry, size_t total);
+
+  /// Fill _counts, _variances and the bootstrap replicas given the bin
+  /// and weight of each event.
+  void _fillReplicas(std::vector<int>& bins,
+		     std::vector<double>& weights,
+		     int numberofreplicas,
+		     unsigned long seed,
+		     int nthreads);
 };
 
 #endif
@@ -6,10 +6,18 @@
 // Updated May 21, 2015 HBP - Implement Fill
 // Updated Mar 10, 2023 HBP - Add constructor that takes an data array
 //                            add indices(bin) method
+// Updated Oct 19, 2026     - Add fillBootstrap (Poisson bootstrap replicas)
+// Updated Oct 19, 2026     - Replace progress prints with metrics and
+//                            optional rate-limited progress reporting
+//                            add build(data, ...) for array data
 // ---------------------------------------------------------------------------
 #include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <thread>
+#include <chrono>
+#include <stdint.h>
 #include "TMath.h"
 #include "TChain.h"
 #include "Turtle.h"
@@ -17,6 +25,15 @@
 
 using namespace std;
 
+namespace {
+  // wall-clock time in seconds
+  double now()
+  {
+    return chrono::duration<double>(chrono::steady_clock::now()
+				     .time_since_epoch()).count();
+  }
+};
+
 Turtle::Turtle()
   : _btree(0),
     _rootfilenames(vector<string>()),
@@ -24,10 +41,16 @@ Turtle::Turtle()
     _treename(""),
     _counts(vector<double>()),
     _variances(vector<double>()),
+    _replicas(vector<double>()),
     _indicesmap(map<int, vector<int> >()),
     _datasize(0),
     _data(0),
-    _point(0)
+    _point(0),
+    _numberofreplicas(0),
+    _metrics(TurtleMetrics()),
+    _interval(0),
+    _lastreport(0),
+    _callback(TurtleCallback())
 {
 }
 
@@ -42,10 +65,16 @@ Turtle::Turtle(string rootfilename,
     _treename(""),
     _counts(vector<double>()),
     _variances(vector<double>()),
+    _replicas(vector<double>()),
     _indicesmap(map<int, vector<int> >()),
     _datasize(0),
     _data(0),
-    _point(0)
+    _point(0),
+    _numberofreplicas(0),
+    _metrics(TurtleMetrics()),
+    _interval(0),
+    _lastreport(0),
+    _callback(TurtleCallback())
 {
   build(rootfilename,
 	variablenames,
@@ -66,10 +95,16 @@ Turtle::Turtle(vector<string>& rootfilenames,
     _treename(""),
     _counts(vector<double>()),
     _variances(vector<double>()),
+    _replicas(vector<double>()),
     _indicesmap(map<int, vector<int> >()),
     _datasize(0),
     _data(0),
-    _point(0)
+    _point(0),
+    _numberofreplicas(0),
+    _metrics(TurtleMetrics()),
+    _interval(0),
+    _lastreport(0),
+    _callback(TurtleCallback())
 {
   build(rootfilenames,
 	variablenames,
@@ -89,10 +124,27 @@ Turtle::Turtle(double* data,
     _treename(""),
     _counts(vector<double>()),
     _variances(vector<double>()),
+    _replicas(vector<double>()),
     _indicesmap(map<int, vector<int> >()),
     _datasize(0),
     _data(0),
-    _point(0)
+    _point(0),
+    _numberofreplicas(0),
+    _metrics(TurtleMetrics()),
+    _interval(0),
+    _lastreport(0),
+    _callback(TurtleCallback())
+{
+  build(data,
+	numberofbins,
+	numberofpoints,
+	numberofvariables);
+}
+
+void Turtle::build(double* data,
+		   int numberofbins,
+		   int numberofpoints,
+		   int numberofvariables)
 {
   _numberofbins    = numberofbins;
   _entries_per_bin = numberofpoints / _numberofbins;
@@ -113,16 +165,15 @@ Turtle::Turtle(double* data,
 
   // Allocate space for a single point
   _point = new double[_numberofvars];
+  _metrics.eventsRead += _datasize;
 
+  double start = now();
   _btree = new TKDTreeBinning(_datasize,
 			      _numberofvars, 
 			      _data, 
 			      _numberofbins);
+  _metrics.partitionTime += now() - start;
   _buildIndicesMap();
-  
-  cout << "number of bins: " << _numberofbins << endl;
-  cout << "entries/bin:    " << _entries_per_bin << endl;
-  cout << "data size:      " << _datasize << endl;
 }
 
 
@@ -151,10 +202,12 @@ void Turtle::build(vector<string>& rootfilenames,
 			   numberofbins,
 			   numberofpoints);
   
+  double start = now();
  _btree = new TKDTreeBinning(_datasize,
 			     variablenames.size(), 
 			     data, 
 			     numberofbins);
+  _metrics.partitionTime += now() - start;
 
   _buildIndicesMap();
   
@@ -210,17 +263,25 @@ void Turtle::fill(std::vector<std::string>& rootfilenames,
   // clear _counts, _variances
   clear();
 
+  double start = now();
+  size_t missed = 0;
   for (int entry=0; entry < numberofpoints; entry++)
     {
       chain.GetEntry(entry);
-      if ( entry % 25000 == 0 ) 
-        cout << entry << endl;
+      _progress("fill", entry, numberofpoints);
       int bin = _btree->FindBin(_point);
-        if ( bin < 0 ) continue;
-	if ( (size_t)bin >= _counts.size() ) continue;
+      if ( bin < 0 || (size_t)bin >= _counts.size() )
+	{
+	  missed++;
+	  continue;
+	}
       _counts[bin] += weight;
       _variances[bin] += weight*weight;
     }
+  _metrics.eventsFilled  += numberofpoints;
+  _metrics.lookups       += numberofpoints;
+  _metrics.lookupsMissed += missed;
+  _metrics.fillTime = now() - start;
 }
 
 void Turtle::fill(std::vector<double>& point, double weight)
@@ -228,9 +289,14 @@ void Turtle::fill(std::vector<double>& point, double weight)
   // Histogram data and store values in _counts
   assert( _btree );
   assert( (size_t)_btree->GetNBins() == _counts.size() );
+  _metrics.eventsFilled++;
+  _metrics.lookups++;
   int bin = _btree->FindBin(&point[0]);
-  if ( bin < 0 ) return;
-  if ( (size_t)bin >= _counts.size() ) return;
+  if ( bin < 0 || (size_t)bin >= _counts.size() )
+    {
+      _metrics.lookupsMissed++;
+      return;
+    }
   _counts[bin] += weight;
   _variances[bin] += weight*weight;
 }
@@ -241,9 +307,14 @@ void Turtle::fill(double* point, double weight)
   // Histogram data and store values in _counts
   assert( _btree );
   assert( (size_t)_btree->GetNBins() == _counts.size() );
+  _metrics.eventsFilled++;
+  _metrics.lookups++;
   int bin = _btree->FindBin(point);
-  if ( bin < 0 ) return;
-  if ( (size_t)bin >= _counts.size() ) return;
+  if ( bin < 0 || (size_t)bin >= _counts.size() )
+    {
+      _metrics.lookupsMissed++;
+      return;
+    }
   _counts[bin] += weight;
   _variances[bin] += weight*weight;
 }
@@ -254,6 +325,234 @@ void Turtle::clear()
   // clear _counts
   transform(_counts.begin(), _counts.end(), _counts.begin(), zero);
   transform(_variances.begin(), _variances.end(), _variances.begin(), zero);
+  transform(_replicas.begin(), _replicas.end(), _replicas.begin(), zero);
+}
+
+
+namespace {
+  // Counter-based random numbers: the Poisson(1) multiplicity of a given
+  // (event, replica) pair is a pure function of (seed, event, replica),
+  // so the replicas do not depend on the order in which they are filled.
+  inline uint64_t mix64(uint64_t z)
+  {
+    // splitmix64 finalizer
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  // cumulative Poisson(1) probabilities scaled to 2^32. The probability
+  // of a multiplicity above the last entry is ~1e-10.
+  const int NCDF = 12;
+  struct PoissonCDF
+  {
+    uint64_t cdf[NCDF];
+    PoissonCDF()
+    {
+      double p = exp(-1.0);
+      double c = 0;
+      for(int k=0; k < NCDF; k++)
+	{
+	  c += p;
+	  p /= k+1;
+	  cdf[k] = (uint64_t)(c * 4294967296.0);
+	}
+    }
+  };
+  const PoissonCDF POISSON1;
+
+  inline int poisson1(uint64_t key, uint64_t replica)
+  {
+    uint64_t u = mix64(key + 0x9e3779b97f4a7c15ULL * (replica + 1)) >> 32;
+    int k = 0;
+    while ( k < NCDF && u >= POISSON1.cdf[k] ) k++;
+    return k;
+  }
+};
+
+void Turtle::fillBootstrap(string rootfilename,
+			   int numberofreplicas,
+			   unsigned long seed,
+			   string weightname,
+			   int nthreads)
+{
+  vector<string> rootfilenames(1, rootfilename);
+  fillBootstrap(rootfilenames, numberofreplicas, seed, weightname, nthreads);
+}
+
+void Turtle::fillBootstrap(vector<string>& rootfilenames,
+			   int numberofreplicas,
+			   unsigned long seed,
+			   string weightname,
+			   int nthreads)
+{
+  assert( _btree );
+  assert( (size_t)_btree->GetNBins() == _counts.size() );
+  if ( numberofreplicas < 0 )
+    {
+      cerr << "Turtle::fillBootstrap: number of replicas must be >= 0, got "
+	   << numberofreplicas << endl;
+      return;
+    }
+
+  TChain chain(_treename.c_str());
+  for (size_t i=0; i < rootfilenames.size(); i++)
+    chain.Add(rootfilenames[i].c_str());
+
+  int numberofpoints = chain.GetEntries();
+
+  for (size_t i=0; i < _variablenames.size(); i++)
+    chain.SetBranchAddress(_variablenames[i].c_str(), &_point[i]);
+
+  double weight = 1.0;
+  if ( weightname != "" )
+    chain.SetBranchAddress(weightname.c_str(), &weight);
+
+  // read the data once, finding the bin of each event
+  double start = now();
+  vector<int>    bins(numberofpoints, -1);
+  vector<double> weights(numberofpoints, 0);
+  for (int entry=0; entry < numberofpoints; entry++)
+    {
+      chain.GetEntry(entry);
+      _progress("fill", entry, numberofpoints);
+      bins[entry]    = _btree->FindBin(_point);
+      weights[entry] = weight;
+    }
+  _fillReplicas(bins, weights, numberofreplicas, seed, nthreads);
+  _metrics.fillTime = now() - start;
+}
+
+void Turtle::fillBootstrap(double* data,
+			   int numberofpoints,
+			   int numberofreplicas,
+			   unsigned long seed,
+			   double* weights,
+			   int nthreads)
+{
+  assert( _btree );
+  assert( (size_t)_btree->GetNBins() == _counts.size() );
+  if ( numberofreplicas < 0 || numberofpoints < 0 )
+    {
+      cerr << "Turtle::fillBootstrap: number of replicas and number of "
+	   << "points must be >= 0, got " << numberofreplicas << " and "
+	   << numberofpoints << endl;
+      return;
+    }
+
+  double start = now();
+  vector<int>    bins(numberofpoints, -1);
+  vector<double> w(numberofpoints, 1.0);
+  for (int entry=0; entry < numberofpoints; entry++)
+    {
+      _progress("fill", entry, numberofpoints);
+      for (size_t j=0; j < _numberofvars; j++)
+        _point[j] = data[j*numberofpoints + entry];
+      bins[entry] = _btree->FindBin(_point);
+      if ( weights ) w[entry] = weights[entry];
+    }
+  _fillReplicas(bins, w, numberofreplicas, seed, nthreads);
+  _metrics.fillTime = now() - start;
+}
+
+void Turtle::_fillReplicas(vector<int>& bins,
+			   vector<double>& weights,
+			   int numberofreplicas,
+			   unsigned long seed,
+			   int nthreads)
+{
+  assert( numberofreplicas >= 0 );
+  size_t nbins = _counts.size();
+  _numberofreplicas = numberofreplicas;
+  _replicas = vector<double>(_numberofreplicas * nbins, 0);
+
+  // clear _counts, _variances
+  clear();
+
+  size_t missed = 0;
+  for (size_t entry=0; entry < bins.size(); entry++)
+    {
+      int bin = bins[entry];
+      if ( bin < 0 || (size_t)bin >= nbins )
+	{
+	  missed++;
+	  continue;
+	}
+      _counts[bin] += weights[entry];
+      _variances[bin] += weights[entry]*weights[entry];
+    }
+  _metrics.eventsFilled  += bins.size();
+  _metrics.lookups       += bins.size();
+  _metrics.lookupsMissed += missed;
+  if ( _numberofreplicas == 0 ) return;
+
+  // Each thread owns a contiguous block of replicas, so there are no
+  // shared writes and every replica is accumulated in event order.
+  size_t nworkers = nthreads > 0 ? nthreads : thread::hardware_concurrency();
+  if ( nworkers < 1 ) nworkers = 1;
+  if ( nworkers > _numberofreplicas ) nworkers = _numberofreplicas;
+  size_t blocksize = (_numberofreplicas + nworkers - 1) / nworkers;
+
+  double* replicas = &_replicas[0];
+  uint64_t seed64  = seed;
+  auto worker = [&bins, &weights, replicas, nbins, seed64](size_t first,
+							   size_t last)
+    {
+      for (size_t entry=0; entry < bins.size(); entry++)
+	{
+	  int bin = bins[entry];
+	  if ( bin < 0 ) continue;
+	  if ( (size_t)bin >= nbins ) continue;
+	  double w = weights[entry];
+	  uint64_t key = mix64(seed64 ^ mix64(entry));
+	  for (size_t r=first; r < last; r++)
+	    {
+	      int k = poisson1(key, r);
+	      if ( k > 0 ) replicas[r*nbins + bin] += k * w;
+	    }
+	}
+    };
+
+  vector<thread> threads;
+  for (size_t first=0; first < _numberofreplicas; first += blocksize)
+    {
+      size_t last = TMath::Min(first + blocksize, _numberofreplicas);
+      threads.push_back(thread(worker, first, last));
+    }
+  for (size_t i=0; i < threads.size(); i++) threads[i].join();
+}
+
+vector<double> Turtle::replicaCounts(int replica)
+{
+  size_t nbins = _counts.size();
+  if ( replica < 0 || (size_t)replica >= _numberofreplicas )
+    return vector<double>();
+  return vector<double>(_replicas.begin() + replica*nbins,
+			_replicas.begin() + (replica+1)*nbins);
+}
+
+vector<double> Turtle::bootstrapVariances()
+{
+  size_t nbins = _counts.size();
+  vector<double> variances(nbins, 0);
+  if ( _numberofreplicas < 2 ) return variances;
+  
+  vector<double> means(nbins, 0);
+  for (size_t r=0; r < _numberofreplicas; r++)
+    for (size_t bin=0; bin < nbins; bin++)
+      means[bin] += _replicas[r*nbins + bin];
+  for (size_t bin=0; bin < nbins; bin++)
+    means[bin] /= _numberofreplicas;
+
+  for (size_t r=0; r < _numberofreplicas; r++)
+    for (size_t bin=0; bin < nbins; bin++)
+      {
+	double d = _replicas[r*nbins + bin] - means[bin];
+	variances[bin] += d*d;
+      }
+  for (size_t bin=0; bin < nbins; bin++)
+    variances[bin] /= _numberofreplicas - 1;
+  return variances;
 }
 
 double* Turtle::_readTree(vector<string>& rootfilenames, 
@@ -285,18 +584,17 @@ double* Turtle::_readTree(vector<string>& rootfilenames,
   for (size_t i=0; i < variablenames.size(); i++)
     chain.SetBranchAddress(variablenames[i].c_str(), &_point[i]);
 
+  double start = now();
   for (size_t entry=0; entry < _datasize; entry++)
     {
       chain.GetEntry(entry);
-      if ( entry % 25000 == 0 ) 
-        cout << entry << endl;
+      _progress("read", entry, _datasize);
 
       for (size_t j=0; j< variablenames.size(); j++)
         _data[entry+j*_datasize] = _point[j];
     }
-  cout << "number of bins: " << _numberofbins << endl;
-  cout << "entries/bin:    " << _entries_per_bin << endl;
-  cout << "data size:      " << _datasize << endl;
+  _metrics.eventsRead += _datasize;
+  _metrics.readTime   += now() - start;
   return &_data[0];
 }
 
@@ -304,7 +602,7 @@ double* Turtle::_readTree(vector<string>& rootfilenames,
 /// Build map from bin number to the indices of the points within the bin
 void Turtle::_buildIndicesMap()
 {
-  cout << "building indices map..." << endl;
+  double start = now();
   // initialize map
   for (size_t bin=0; bin < _numberofbins; bin++)
     {
@@ -317,11 +615,7 @@ void Turtle::_buildIndicesMap()
   // 3. add index of point to bin to index map
   for (size_t entry=0; entry < _datasize; entry++)
     {
-      if ( entry % 50000 == 0 )
-	{
-	  char str[80];
-	  printf("  %10d\n", (int)entry); 
-	}
+      _progress("index", entry, _datasize);
       
       // 1. get point
       for (size_t j=0; j < _numberofvars; j++)
@@ -333,7 +627,8 @@ void Turtle::_buildIndicesMap()
 	
       _indicesmap[bin].push_back(entry);
     }
-  cout << "done" << endl;
+  _metrics.lookups   += _datasize;
+  _metrics.indexTime += now() - start;
 }
 
 std::vector<int>  Turtle::indices(int bin)
@@ -347,3 +642,80 @@ std::vector<int>  Turtle::indices(int bin)
       return vector<int>();
     } 
 }
+
+
+TurtleMetrics Turtle::metrics()
+{
+  // occupancy statistics and memory use are computed on demand so that
+  // they cost nothing unless asked for
+  TurtleMetrics m = _metrics;
+  size_t ndoubles = _datasize * _numberofvars + _counts.size()
+    + _variances.size() + _replicas.size() + (_point ? _numberofvars : 0);
+  m.bytesAllocated = ndoubles * sizeof(double) + _datasize * sizeof(int);
+  if ( _btree )
+    {
+      // TKDTreeBinning keeps its own copy of the data, an index of the
+      // points, the min/max edges of each bin and the bin contents
+      size_t nbins = _btree->GetNBins();
+      m.bytesAllocated += (_datasize * _numberofvars
+			   + 2 * nbins * _numberofvars) * sizeof(double)
+	+ (_datasize + nbins) * sizeof(unsigned int);
+    }
+  if ( _indicesmap.size() > 0 )
+    {
+      m.minOccupancy = _indicesmap.begin()->second.size();
+      m.maxOccupancy = m.minOccupancy;
+      for (map<int, vector<int> >::iterator it=_indicesmap.begin();
+	   it != _indicesmap.end(); it++)
+	{
+	  m.minOccupancy = TMath::Min(m.minOccupancy, it->second.size());
+	  m.maxOccupancy = TMath::Max(m.maxOccupancy, it->second.size());
+	}
+      double mean = (double)_datasize / _indicesmap.size();
+      if ( mean > 0 ) m.imbalance = m.maxOccupancy / mean;
+    }
+  if ( _counts.size() > 0 )
+    {
+      m.minCount = *min_element(_counts.begin(), _counts.end());
+      m.maxCount = *max_element(_counts.begin(), _counts.end());
+    }
+  return m;
+}
+
+void Turtle::printMetrics()
+{
+  TurtleMetrics m = metrics();
+  cout << "number of bins:     " << _numberofbins << endl;
+  cout << "entries/bin:        " << _entries_per_bin << endl;
+  cout << "data size:          " << _datasize << endl;
+  cout << "read time (s):      " << m.readTime << endl;
+  cout << "partition time (s): " << m.partitionTime << endl;
+  cout << "index time (s):     " << m.indexTime << endl;
+  cout << "fill time (s):      " << m.fillTime << endl;
+  cout << "events read:        " << m.eventsRead << endl;
+  cout << "events filled:      " << m.eventsFilled << endl;
+  cout << "lookups:            " << m.lookups
+       << " (missed " << m.lookupsMissed << ")" << endl;
+  cout << "occupancy min/max:  " << m.minOccupancy << " / "
+       << m.maxOccupancy << " (imbalance " << m.imbalance << ")" << endl;
+  cout << "count min/max:      " << m.minCount << " / " << m.maxCount << endl;
+  cout << "bytes allocated:    " << m.bytesAllocated << endl;
+}
+
+void Turtle::setProgress(double interval, TurtleCallback callback)
+{
+  _interval   = interval;
+  _callback   = callback;
+  _lastreport = 0;
+}
+
+void Turtle::_report(const char* phase, size_t entry, size_t total)
+{
+  double t = now();
+  if ( entry > 0 && t - _lastreport < _interval ) return;
+  _lastreport = t;
+  if ( _callback )
+    _callback(phase, entry, total);
+  else
+    cout << "Turtle: " << phase << " " << entry << "/" << total << endl;
+}
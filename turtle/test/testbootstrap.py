@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+#-----------------------------------------------------------------------------
+import numpy as np
+import pandas as pd
+import turtlebinning as tb
+
+from array import array
+from ROOT import nullptr
+#-----------------------------------------------------------------------------
+def generate_data(npoints):
+    # generate data and create a dataframe
+    x  = np.random.normal(loc=0, scale=1, size=npoints)
+    y  = np.random.normal(loc=0, scale=2, size=npoints)
+    df = pd.DataFrame({'x': x, 'y': y})
+    return df
+#-----------------------------------------------------------------------------
+def main():
+
+    nbins   = 100        # number of bins
+    npoints_per_bin = 50 # number of points per bin
+    npoints = nbins * npoints_per_bin
+    
+    df   = generate_data(npoints)
+    data = array('d')
+    data.extend(df['x'])
+    data.extend(df['y'])
+
+    # bin data
+    nparams = 2
+    ttb     = tb.Turtle(data, nbins, npoints, nparams)
+
+    # fill bootstrap replicas of the same data
+    R    = 400
+    seed = 42
+    ttb.fillBootstrap(data, npoints, R, seed)
+    assert ttb.nReplicas() == R
+
+    counts = np.array(ttb.counts())
+    var    = np.array(ttb.bootstrapVariances())
+    means  = np.array([list(ttb.replicaCounts(r)) for r in range(R)]).mean(0)
+
+    # for unit weights the bootstrap mean and variance of each bin
+    # should both be close to the bin count: the mean to within
+    # ~sqrt(count/R) and the variance to within ~count*sqrt(3/R)
+    print(f'mean(count):              {counts.mean():10.2f}')
+    print(f'mean(replica mean):       {means.mean():10.2f}')
+    print(f'mean(bootstrap variance): {var.mean():10.2f}')
+    assert np.all(np.abs(means - counts) < 5*np.sqrt(counts/R))
+    assert np.all(np.abs(var - counts) < 5*counts*np.sqrt(3/R))
+    assert abs(var.mean() / counts.mean() - 1) < 0.05
+
+    # replicas must be reproducible for a given seed, whatever the
+    # number of threads
+    first = list(ttb.replicaCounts(R-1))
+    ttb.fillBootstrap(data, npoints, R, seed, nullptr, 1)
+    assert list(ttb.replicaCounts(R-1)) == first
+    print('replicas reproducible')
+#----------------------------------------------------------------------------
+main()
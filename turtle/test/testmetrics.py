@@ -0,0 +1,74 @@
+#!/usr/bin/env python
+#-----------------------------------------------------------------------------
+import numpy as np
+import pandas as pd
+import turtlebinning as tb
+
+from array import array
+#-----------------------------------------------------------------------------
+def generate_data(npoints):
+    # generate data and create a dataframe
+    x  = np.random.normal(loc=0, scale=1, size=npoints)
+    y  = np.random.normal(loc=0, scale=2, size=npoints)
+    df = pd.DataFrame({'x': x, 'y': y})
+    return df
+#-----------------------------------------------------------------------------
+def main():
+
+    nbins   = 100        # number of bins
+    npoints_per_bin = 50 # number of points per bin
+    npoints = nbins * npoints_per_bin
+    
+    df   = generate_data(npoints)
+    data = array('d')
+    data.extend(df['x'])
+    data.extend(df['y'])
+
+    # enable progress reporting before the data are binned
+    phases = set()
+    def progress(phase, entry, total):
+        phases.add(str(phase))
+        assert 0 <= entry < total
+
+    nparams = 2
+    ttb = tb.Turtle()
+    ttb.setProgress(1e-9, progress)
+    ttb.build(data, nbins, npoints, nparams)
+    assert 'index' in phases
+
+    m = ttb.metrics()
+    assert m.eventsRead == npoints
+    assert m.lookups == npoints
+    assert m.eventsFilled == 0
+    assert m.minOccupancy <= m.maxOccupancy
+    assert m.imbalance >= 1
+    assert m.bytesAllocated > 2 * npoints * nparams * 8
+    assert m.partitionTime >= 0 and m.indexTime >= 0
+
+    # public bin lookups are not counted
+    ttb.findBin(array('d', [0, 0]))
+    assert ttb.metrics().lookups == npoints
+
+    # histogram the same points
+    point = array('d', [0, 0])
+    for ii in range(npoints):
+        point[0] = df['x'].iloc[ii]
+        point[1] = df['y'].iloc[ii]
+        ttb.fill(point)
+
+    m = ttb.metrics()
+    assert m.eventsFilled == npoints
+    assert m.lookups == 2 * npoints
+    assert m.lookupsMissed == 0
+    assert m.minCount <= m.maxCount
+    assert sum(ttb.counts()) == npoints
+
+    # the array fill reports progress under "fill"
+    ttb.fillBootstrap(data, npoints, 10)
+    assert 'fill' in phases
+    assert ttb.metrics().eventsFilled == 2 * npoints
+
+    ttb.printMetrics()
+    print('metrics OK')
+#----------------------------------------------------------------------------
+main()
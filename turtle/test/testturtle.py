@@ -59,5 +59,8 @@ def main():
                     print()
             if ll < 10:
                 print()
+
+    # timers, counters and bin statistics
+    ttb.printMetrics()
 #----------------------------------------------------------------------------
 main()